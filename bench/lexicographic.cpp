@@ -0,0 +1,105 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+// Compares sorting on three keys with lift::lexicographic, std::tie and
+// a comparator built from nested lift::compose/lift::if_then_else.
+
+#include <lift.hpp>
+#include <lift_lexicographic.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct record
+{
+  std::string name;
+  int         age;
+  double      score;
+};
+
+constexpr auto select_name = [](const record& r) -> const std::string& { return r.name; };
+constexpr auto select_age = [](const record& r) { return r.age; };
+constexpr auto select_score = [](const record& r) { return r.score; };
+
+std::vector<record>
+make_records(
+  std::size_t size)
+{
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> name(0, 63);
+  std::uniform_int_distribution<int> age(18, 67);
+  std::uniform_real_distribution<double> score(0.0, 100.0);
+  std::vector<record> v;
+  v.reserve(size);
+  while (v.size() != size)
+  {
+    v.push_back({"employee_" + std::to_string(name(gen)), age(gen), score(gen)});
+  }
+  return v;
+}
+
+template <typename Compare>
+void
+run(
+  const char* name,
+  const std::vector<record>& input,
+  Compare compare)
+{
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i != 5; ++i)
+  {
+    auto v = input;
+    const auto start = std::chrono::steady_clock::now();
+    std::sort(v.begin(), v.end(), compare);
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  const auto ms = std::chrono::duration<double, std::milli>(best).count();
+  std::printf("%-14s %10.2f ms\n", name, ms);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  const auto size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000UL;
+  const auto input = make_records(size);
+
+  run("lexicographic", input,
+      lift::lexicographic(select_name, select_age, lift::descending(select_score)));
+
+  run("std::tie", input,
+      [](const record& l, const record& r) {
+        return std::tie(l.name, l.age, r.score) < std::tie(r.name, r.age, l.score);
+      });
+
+  const auto by = [](auto projection) {
+    return lift::compose(std::less<>{}, projection);
+  };
+  const auto same = [](auto projection) {
+    return lift::compose(std::equal_to<>{}, projection);
+  };
+  run("nested compose", input,
+      lift::if_then_else(same(select_name),
+                         lift::if_then_else(same(select_age),
+                                            lift::compose(std::greater<>{}, select_score),
+                                            by(select_age)),
+                         by(select_name)));
+}
@@ -0,0 +1,101 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+// Counts records by a member of an object they point to, where the
+// pointed to objects are scattered over a region much larger than the
+// last level cache. Compares std::count_if with lift::count_if_prefetched
+// at several prefetch distances.
+
+#include <lift.hpp>
+#include <lift_prefetch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct alignas(64) owner
+{
+  int id;
+};
+
+struct record
+{
+  const owner* o;
+  int          value;
+};
+
+constexpr auto select_owner = [](const record& r) { return r.o; };
+constexpr auto select_owner_id = [](const record& r) { return r.o->id; };
+
+template <typename F>
+void
+run(
+  const char* name,
+  F f)
+{
+  auto best = std::chrono::steady_clock::duration::max();
+  long result = 0;
+  for (int i = 0; i != 5; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    result = long(f());
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  const auto ms = std::chrono::duration<double, std::milli>(best).count();
+  std::printf("%-22s %10.2f ms (%ld)\n", name, ms, result);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  // the default is 4M owners of 64 bytes each, 256MiB
+  const auto size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4UL << 20;
+
+  std::mt19937 gen(17);
+  std::vector<owner> owners(size);
+  for (auto& o : owners)
+  {
+    o.id = int(gen() % 100);
+  }
+  std::vector<std::size_t> order(size);
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::shuffle(order.begin(), order.end(), gen);
+  std::vector<record> records;
+  records.reserve(size);
+  for (auto i : order)
+  {
+    records.push_back({&owners[i], int(i)});
+  }
+
+  const auto pred = lift::compose(lift::equal(42), select_owner_id);
+
+  run("std::count_if", [&] {
+    return std::count_if(records.begin(), records.end(), pred);
+  });
+  for (std::size_t distance : {4U, 8U, 16U, 32U, 64U})
+  {
+    char name[32];
+    std::snprintf(name, sizeof(name), "prefetched, d=%zu", distance);
+    run(name, [&] {
+      return lift::count_if_prefetched(records.begin(), records.end(), pred,
+                                       select_owner, distance);
+    });
+  }
+}
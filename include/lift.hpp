@@ -14,6 +14,7 @@
 #ifndef HIGHER_ORDER_FUNCTIONS_LIFT_HPP
 #define HIGHER_ORDER_FUNCTIONS_LIFT_HPP
 
+#include <type_traits>
 #include <utility>
 #include <tuple>
 
@@ -32,8 +33,130 @@
 #define LIFT LIFT_FUNCTION
 #endif
 
+#define LIFT_THRICE(...)                \
+        noexcept(noexcept(__VA_ARGS__)) \
+        -> decltype(__VA_ARGS__)        \
+        {                               \
+          return __VA_ARGS__;           \
+        }
+
+#define LIFT_FWD(x) std::forward<decltype(x)>(x)
+
 namespace lift {
 
+constexpr std::size_t default_cost = 100;
+
+namespace detail
+{
+  template <std::size_t N, typename F>
+  struct costed
+  {
+    static constexpr std::size_t cost = N;
+
+    // declared before operator(), which uses it in its return type
+    F f;
+
+    template <typename ... T>
+    constexpr
+    auto
+    operator()(
+      T&& ... t)
+    const
+    LIFT_THRICE(f(std::forward<T>(t)...))
+  };
+
+  template <typename F>
+  struct predicate_cost : std::integral_constant<std::size_t, default_cost> {};
+
+  template <std::size_t N, typename F>
+  struct predicate_cost<costed<N, F>> : std::integral_constant<std::size_t, N> {};
+
+  template <std::size_t N>
+  struct indexes
+  {
+    // never empty, so that there is an array also without predicates
+    std::size_t index[N + 1];
+  };
+
+  template <std::size_t ... Costs>
+  constexpr
+  indexes<sizeof...(Costs)>
+  cost_order()
+  {
+    constexpr std::size_t costs[] = {Costs..., 0};
+    constexpr std::size_t size = sizeof...(Costs);
+    indexes<size> order{};
+    for (std::size_t i = 0; i != size; ++i)
+    {
+      order.index[i] = i;
+    }
+    // insertion sort, since it is stable and the number of predicates small
+    for (std::size_t i = 1; i < size; ++i)
+    {
+      for (auto j = i; j != 0 && costs[order.index[j - 1]] > costs[order.index[j]]; --j)
+      {
+        const auto tmp = order.index[j];
+        order.index[j] = order.index[j - 1];
+        order.index[j - 1] = tmp;
+      }
+    }
+    return order;
+  }
+
+  template <typename ... Fs, std::size_t ... I>
+  constexpr
+  auto
+  by_cost(
+    std::index_sequence<I...>)
+  {
+    constexpr auto order = cost_order<predicate_cost<Fs>::value...>();
+    return std::index_sequence<order.index[I]...>{};
+  }
+
+  template <typename ... Fs>
+  using index_sequence_by_cost =
+    decltype(by_cost<std::decay_t<Fs>...>(std::index_sequence_for<Fs...>{}));
+}
+
+template <std::size_t N, typename F>
+inline
+constexpr
+auto
+cost(
+  F&& f)
+{
+  return detail::costed<N, std::decay_t<F>>{std::forward<F>(f)};
+}
+
+namespace detail
+{
+  template <typename F>
+  struct is_costed : std::false_type {};
+
+  template <std::size_t N, typename F>
+  struct is_costed<costed<N, F>> : std::true_type {};
+
+  // Annotates f, which calls all of Fs, with the sum of their costs, but
+  // only if any of them is annotated. Unannotated functions count as
+  // default_cost, so they are never made cheaper than an unannotated guard.
+  template <typename ... Fs, typename F>
+  inline
+  constexpr
+  auto
+  cost_of(
+    F&& f)
+  {
+    if constexpr ((is_costed<std::decay_t<Fs>>::value || ...))
+    {
+      return cost<(predicate_cost<std::decay_t<Fs>>::value + ...)>(std::forward<F>(f));
+    }
+    else
+    {
+      return std::decay_t<F>(std::forward<F>(f));
+    }
+  }
+}
+
 template <typename F>
 inline
 constexpr
@@ -112,7 +235,7 @@ compose(
   F&& f,
   Fs&&... fs)
 {
-  return [f = std::forward<F>(f), tail = compose(std::forward<Fs>(fs)...)]
+  auto composed = [f = std::forward<F>(f), tail = compose(std::forward<Fs>(fs)...)]
     (auto&& ... objs)
     noexcept(noexcept(detail::compose(typename std::is_invocable<decltype(compose(std::forward<Fs>(fs)...)), decltype(objs)...>::type{},
                                       std::bool_constant<(std::is_invocable_v<decltype(compose(std::forward<Fs>(fs)...)), decltype(objs)>  && ...)>{},
@@ -134,6 +257,7 @@ compose(
 
     return detail::compose(unitail, std::bool_constant<multitail>{}, f, tail, LIFT_FWD(objs)...);
   };
+  return detail::cost_of<F, Fs...>(std::move(composed));
 }
 
 template <typename F>
@@ -143,8 +267,8 @@ auto
 negate(
   F&& f)
 {
-  return
-    [f = std::forward<F>(f)](auto&& ... obj) LIFT_THRICE(!f(LIFT_FWD(obj)...));
+  return detail::cost_of<F>(
+    [f = std::forward<F>(f)](auto&& ... obj) LIFT_THRICE(!f(LIFT_FWD(obj)...)));
 }
 
 template <typename T>
@@ -154,7 +278,7 @@ auto
 equal(
   T &&t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj == t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj == t));
 }
 
 template <typename T>
@@ -164,7 +288,7 @@ auto
 not_equal(
   T&& t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj != t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj != t));
 }
 
 template <typename T>
@@ -174,7 +298,7 @@ auto
 less_than(
   T&& t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj < t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj < t));
 }
 
 template <typename T>
@@ -184,7 +308,7 @@ auto
 less_equal(
   T&& t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj <= t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj <= t));
 }
 
 template <typename T>
@@ -194,7 +318,7 @@ auto
 greater_than(
   T&& t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj > t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj > t));
 }
 
 template <typename T>
@@ -204,7 +328,7 @@ constexpr
 greater_equal(
   T&& t)
 {
-  return [t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj >= t);
+  return cost<1>([t = std::forward<T>(t)](const auto& obj) LIFT_THRICE(obj >= t));
 }
 
 namespace detail
@@ -238,7 +362,7 @@ when_all(
   {
     return detail::when_all(
       funcs,
-      std::index_sequence_for<Fs...>{},
+      detail::index_sequence_by_cost<Fs...>{},
       obj...
     );
   };
@@ -275,7 +399,7 @@ when_any(
   {
     return detail::when_any(
       funcs,
-      std::index_sequence_for<Fs...>{},
+      detail::index_sequence_by_cost<Fs...>{},
       obj...
     );
   };
@@ -0,0 +1,523 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#ifndef HIGHER_ORDER_FUNCTIONS_LIFT_ASYNC_HPP
+#define HIGHER_ORDER_FUNCTIONS_LIFT_ASYNC_HPP
+
+#include "lift.hpp"
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "lift_async.hpp requires C++20 coroutines"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace lift {
+
+
+template <typename T = void>
+class task;
+
+namespace detail
+{
+  template <typename T, typename = void>
+  struct has_member_co_await : std::false_type {};
+
+  template <typename T>
+  struct has_member_co_await<T, std::void_t<decltype(std::declval<T>().operator co_await())>>
+    : std::true_type {};
+
+  template <typename T, typename = void>
+  struct is_awaiter : std::false_type {};
+
+  template <typename T>
+  struct is_awaiter<T, std::void_t<decltype(std::declval<T&>().await_ready()),
+                                   decltype(std::declval<T&>().await_resume())>>
+    : std::true_type {};
+
+  template <typename T>
+  constexpr bool is_awaitable = has_member_co_await<T>{} || is_awaiter<T>{};
+
+  template <typename T, bool = has_member_co_await<T>{}, bool = is_awaiter<T>{}>
+  struct await_result
+  {
+    using type = T;
+  };
+
+  template <typename T, bool B>
+  struct await_result<T, true, B>
+  {
+    using awaiter = decltype(std::declval<T>().operator co_await());
+    using type = std::decay_t<decltype(std::declval<awaiter&>().await_resume())>;
+  };
+
+  template <typename T>
+  struct await_result<T, false, true>
+  {
+    using type = std::decay_t<decltype(std::declval<T&>().await_resume())>;
+  };
+
+  template <typename T>
+  using await_result_t = typename await_result<std::decay_t<T>>::type;
+
+  struct task_final_awaiter
+  {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    std::coroutine_handle<>
+    await_suspend(
+      std::coroutine_handle<P> h)
+    noexcept
+    {
+      const auto continuation = h.promise().continuation;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  struct task_promise_base
+  {
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    task_final_awaiter final_suspend() const noexcept { return {}; }
+
+    std::coroutine_handle<> continuation;
+  };
+
+  template <typename T>
+  struct task_promise : task_promise_base
+  {
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void
+    return_value(
+      U&& u)
+    {
+      result.template emplace<1>(std::forward<U>(u));
+    }
+
+    void
+    unhandled_exception()
+    noexcept
+    {
+      result.template emplace<2>(std::current_exception());
+    }
+
+    T
+    get()
+    {
+      if (result.index() == 2)
+      {
+        std::rethrow_exception(std::get<2>(result));
+      }
+      return std::move(std::get<1>(result));
+    }
+
+    std::variant<std::monostate, T, std::exception_ptr> result;
+  };
+
+  template <>
+  struct task_promise<void> : task_promise_base
+  {
+    task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void
+    unhandled_exception()
+    noexcept
+    {
+      error = std::current_exception();
+    }
+
+    void
+    get()
+    const
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    std::exception_ptr error;
+  };
+
+  // A coroutine that starts immediately and destroys itself when done.
+  struct detached
+  {
+    struct promise_type
+    {
+      detached get_return_object() const noexcept { return {}; }
+      std::suspend_never initial_suspend() const noexcept { return {}; }
+      std::suspend_never final_suspend() const noexcept { return {}; }
+      void return_void() const noexcept {}
+      void unhandled_exception() const noexcept { std::terminate(); }
+    };
+  };
+}
+
+template <typename T>
+class task
+{
+public:
+  using promise_type = detail::task_promise<T>;
+
+  task(
+    task&& t)
+  noexcept
+    : handle(std::exchange(t.handle, {}))
+  {
+  }
+
+  task&
+  operator=(
+    task&& t)
+  noexcept
+  {
+    std::swap(handle, t.handle);
+    return *this;
+  }
+
+  ~task()
+  {
+    if (handle) handle.destroy();
+  }
+
+  auto
+  operator co_await()
+  && noexcept
+  {
+    struct awaiter
+    {
+      bool await_ready() const noexcept { return !handle || handle.done(); }
+
+      std::coroutine_handle<>
+      await_suspend(
+        std::coroutine_handle<> continuation)
+      noexcept
+      {
+        handle.promise().continuation = continuation;
+        return handle;
+      }
+
+      T await_resume() { return handle.promise().get(); }
+
+      std::coroutine_handle<promise_type> handle;
+    };
+    return awaiter{handle};
+  }
+private:
+  friend promise_type;
+
+  explicit
+  task(
+    std::coroutine_handle<promise_type> h)
+  noexcept
+    : handle(h)
+  {
+  }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail
+{
+  template <typename T>
+  inline
+  task<T>
+  task_promise<T>::get_return_object()
+  noexcept
+  {
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+
+  inline
+  task<void>
+  task_promise<void>::get_return_object()
+  noexcept
+  {
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+  }
+
+  template <std::size_t I, typename Fs, typename V>
+  using stage_result_t = std::invoke_result_t<const std::tuple_element_t<I, Fs>&, V>;
+
+  template <std::size_t I, typename Fs, typename V>
+  struct async_result
+  {
+    using type = typename async_result<I - 1, Fs, await_result_t<stage_result_t<I, Fs, V>>>::type;
+  };
+
+  template <typename Fs, typename V>
+  struct async_result<0, Fs, V>
+  {
+    using type = await_result_t<stage_result_t<0, Fs, V>>;
+  };
+
+  // The index of the first stage, counting down from I, that returns an
+  // awaitable, or 0 if all remaining stages are synchronous.
+  template <std::size_t I, typename Fs, typename V>
+  constexpr
+  std::size_t
+  sync_stop()
+  {
+    using result = stage_result_t<I, Fs, V>;
+    if constexpr (I == 0 || is_awaitable<result>)
+    {
+      return I;
+    }
+    else
+    {
+      return sync_stop<I - 1, Fs, result>();
+    }
+  }
+
+  template <std::size_t I, typename Fs, typename V>
+  inline
+  constexpr
+  auto
+  run_sync(
+    const Fs& fs,
+    V&& v)
+  {
+    using result = stage_result_t<I, Fs, V>;
+    if constexpr (I == 0 || is_awaitable<result>)
+    {
+      return std::get<I>(fs)(std::forward<V>(v));
+    }
+    else
+    {
+      return run_sync<I - 1>(fs, std::get<I>(fs)(std::forward<V>(v)));
+    }
+  }
+
+  // The stages are shared with the function object from compose_async,
+  // so that a task started after it is destroyed does not dangle.
+  template <std::size_t I, typename Fs, typename V>
+  task<typename async_result<I, Fs, V>::type>
+  run_async(
+    std::shared_ptr<const Fs> fs,
+    V v)
+  {
+    constexpr auto stop = sync_stop<I, Fs, V>();
+    auto r = run_sync<I>(*fs, std::move(v));
+    if constexpr (!is_awaitable<decltype(r)>)
+    {
+      co_return r;
+    }
+    else if constexpr (stop == 0)
+    {
+      co_return co_await std::move(r);
+    }
+    else
+    {
+      co_return co_await run_async<stop - 1>(fs, co_await std::move(r));
+    }
+  }
+
+  template <typename It, typename F, typename Sink>
+  struct async_window
+  {
+    async_window(
+      It first,
+      It l,
+      F f,
+      Sink s)
+      : next(first)
+      , last(l)
+      , function(std::move(f))
+      , sink(std::move(s))
+    {
+    }
+
+    It next;
+    It last;
+    F function;
+    Sink sink;
+    std::mutex mutex;
+    std::atomic<std::size_t> workers{0};
+    std::exception_ptr error;
+    std::coroutine_handle<> parent;
+  };
+
+  template <typename It, typename F, typename Sink>
+  detached
+  async_worker(
+    async_window<It, F, Sink>& w)
+  {
+    for (;;)
+    {
+      It i;
+      {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.next == w.last || w.error) break;
+        i = w.next++;
+      }
+      try
+      {
+        auto r = co_await w.function(*i);
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.sink(std::move(r));
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.error) w.error = std::current_exception();
+      }
+    }
+    if (w.workers.fetch_sub(1) == 1)
+    {
+      w.parent.resume();
+    }
+  }
+
+  template <typename It, typename F, typename Sink>
+  struct start_async_window
+  {
+    bool await_ready() const noexcept { return false; }
+
+    bool
+    await_suspend(
+      std::coroutine_handle<> h)
+    {
+      w.parent = h;
+      // one extra count for this call, so that workers that finish
+      // before all are started do not resume the parent
+      w.workers = max_in_flight + 1;
+      for (std::size_t i = 0; i != max_in_flight; ++i)
+      {
+        async_worker(w);
+      }
+      return w.workers.fetch_sub(1) != 1;
+    }
+
+    void await_resume() const noexcept {}
+
+    async_window<It, F, Sink>& w;
+    std::size_t max_in_flight;
+  };
+
+  template <typename T>
+  struct sync_wait_state
+  {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done = false;
+    std::optional<T> value;
+    std::exception_ptr error;
+  };
+
+  template <>
+  struct sync_wait_state<void>
+  {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done = false;
+    std::exception_ptr error;
+  };
+
+  template <typename A, typename T>
+  detached
+  sync_wait_driver(
+    A& awaitable,
+    sync_wait_state<T>& s)
+  {
+    try
+    {
+      if constexpr (std::is_void_v<T>)
+      {
+        co_await std::move(awaitable);
+      }
+      else
+      {
+        s.value.emplace(co_await std::move(awaitable));
+      }
+    }
+    catch (...)
+    {
+      s.error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.done = true;
+    s.cond.notify_one();
+  }
+}
+
+template <typename ... Fs>
+inline
+auto
+compose_async(
+  Fs&& ... fs)
+{
+  using funcs_type = std::tuple<std::decay_t<Fs>...>;
+  return [funcs = std::make_shared<const funcs_type>(std::forward<Fs>(fs)...)](auto obj)
+  {
+    return detail::run_async<sizeof...(Fs) - 1>(funcs, std::move(obj));
+  };
+}
+
+template <typename It, typename F, typename Sink>
+task<>
+for_each_async(
+  It first,
+  It last,
+  F function,
+  Sink sink,
+  std::size_t max_in_flight)
+{
+  detail::async_window<It, F, Sink> w(first, last, std::move(function), std::move(sink));
+  co_await detail::start_async_window<It, F, Sink>{w, std::max<std::size_t>(max_in_flight, 1)};
+  if (w.error)
+  {
+    std::rethrow_exception(w.error);
+  }
+}
+
+template <typename A>
+auto
+sync_wait(
+  A&& awaitable)
+{
+  using result_type = detail::await_result_t<A>;
+  detail::sync_wait_state<result_type> s;
+  detail::sync_wait_driver(awaitable, s);
+  std::unique_lock<std::mutex> lock(s.mutex);
+  s.cond.wait(lock, [&s] { return s.done; });
+  if (s.error)
+  {
+    std::rethrow_exception(s.error);
+  }
+  if constexpr (!std::is_void_v<result_type>)
+  {
+    return std::move(*s.value);
+  }
+}
+
+}
+
+#endif //HIGHER_ORDER_FUNCTIONS_LIFT_ASYNC_HPP
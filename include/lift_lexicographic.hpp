@@ -0,0 +1,219 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#ifndef HIGHER_ORDER_FUNCTIONS_LIFT_LEXICOGRAPHIC_HPP
+#define HIGHER_ORDER_FUNCTIONS_LIFT_LEXICOGRAPHIC_HPP
+
+#include "lift.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lift {
+
+namespace detail
+{
+  template <typename T>
+  constexpr bool is_std_string =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+  template <typename C>
+  struct three_way_comparator
+  {
+    C comparator;
+  };
+
+  template <typename C>
+  struct is_three_way : std::false_type {};
+
+  template <typename C>
+  struct is_three_way<three_way_comparator<C>> : std::true_type {};
+
+  template <typename C, typename L, typename R>
+  inline
+  constexpr
+  int
+  three_way_compare(
+    const C& compare,
+    const L& lh,
+    const R& rh)
+  {
+    constexpr bool is_less = std::is_same_v<C, std::less<>> || std::is_same_v<C, std::less<L>>;
+    if constexpr (is_three_way<C>{})
+    {
+      const auto c = compare.comparator(lh, rh);
+      return (c > 0) - (c < 0);
+    }
+    else if constexpr (is_less && is_std_string<L> && is_std_string<R>)
+    {
+      const auto c = std::string_view(lh).compare(std::string_view(rh));
+      return (c > 0) - (c < 0);
+    }
+    else if constexpr (is_less && std::is_arithmetic_v<L> && std::is_arithmetic_v<R>)
+    {
+      return (rh < lh) - (lh < rh);
+    }
+    else
+    {
+      return compare(lh, rh) ? -1 : compare(rh, lh) ? 1 : 0;
+    }
+  }
+
+  template <typename P, typename C, bool Descending>
+  struct lexicographic_key
+  {
+    template <typename L, typename R>
+    constexpr
+    int
+    compare(
+      const L& lh,
+      const R& rh)
+    const
+    {
+      return Descending
+        ? three_way_compare(comparator, rh, lh)
+        : three_way_compare(comparator, lh, rh);
+    }
+
+    template <typename L, typename R>
+    constexpr
+    bool
+    less(
+      const L& lh,
+      const R& rh)
+    const
+    {
+      if constexpr (is_three_way<C>{})
+      {
+        return compare(lh, rh) < 0;
+      }
+      else
+      {
+        return Descending ? comparator(rh, lh) : comparator(lh, rh);
+      }
+    }
+
+    P projection;
+    C comparator;
+  };
+
+  template <typename T>
+  struct is_lexicographic_key : std::false_type {};
+
+  template <typename P, typename C, bool D>
+  struct is_lexicographic_key<lexicographic_key<P, C, D>> : std::true_type {};
+
+  template <typename K>
+  inline
+  constexpr
+  auto
+  as_lexicographic_key(
+    K&& k)
+  {
+    if constexpr (is_lexicographic_key<std::decay_t<K>>{})
+    {
+      return std::forward<K>(k);
+    }
+    else
+    {
+      return lexicographic_key<std::decay_t<K>, std::less<>, false>{std::forward<K>(k), {}};
+    }
+  }
+
+  template <std::size_t I, typename Keys, typename L, typename R>
+  inline
+  constexpr
+  bool
+  lexicographic_less(
+    const Keys& keys,
+    const L& lh,
+    const R& rh)
+  {
+    const auto& key = std::get<I>(keys);
+    const auto& l = key.projection(lh);
+    const auto& r = key.projection(rh);
+    if constexpr (I + 1 == std::tuple_size_v<Keys>)
+    {
+      return key.less(l, r);
+    }
+    else
+    {
+      const int c = key.compare(l, r);
+      return c != 0 ? c < 0 : lexicographic_less<I + 1>(keys, lh, rh);
+    }
+  }
+}
+
+template <typename C>
+inline
+constexpr
+auto
+three_way(
+  C&& comparator)
+{
+  return detail::three_way_comparator<std::decay_t<C>>{std::forward<C>(comparator)};
+}
+
+template <typename P, typename C = std::less<>>
+inline
+constexpr
+auto
+ascending(
+  P&& projection,
+  C&& comparator = C{})
+{
+  return detail::lexicographic_key<std::decay_t<P>, std::decay_t<C>, false>{
+    std::forward<P>(projection),
+    std::forward<C>(comparator)
+  };
+}
+
+template <typename P, typename C = std::less<>>
+inline
+constexpr
+auto
+descending(
+  P&& projection,
+  C&& comparator = C{})
+{
+  return detail::lexicographic_key<std::decay_t<P>, std::decay_t<C>, true>{
+    std::forward<P>(projection),
+    std::forward<C>(comparator)
+  };
+}
+
+template <typename K, typename ... Ks>
+inline
+constexpr
+auto
+lexicographic(
+  K&& k,
+  Ks&& ... ks)
+{
+  return
+    [keys = std::tuple(detail::as_lexicographic_key(std::forward<K>(k)),
+                       detail::as_lexicographic_key(std::forward<Ks>(ks))...)]
+      (const auto& lh, const auto& rh)
+  -> bool
+  {
+    return detail::lexicographic_less<0>(keys, lh, rh);
+  };
+}
+}
+
+#endif //HIGHER_ORDER_FUNCTIONS_LIFT_LEXICOGRAPHIC_HPP
@@ -0,0 +1,114 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#ifndef HIGHER_ORDER_FUNCTIONS_LIFT_PREFETCH_HPP
+#define HIGHER_ORDER_FUNCTIONS_LIFT_PREFETCH_HPP
+
+#include "lift.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace lift {
+
+namespace detail
+{
+  template <typename T>
+  inline
+  void
+  prefetch(
+    const T* p)
+  noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#else
+    (void)p;
+#endif
+  }
+
+  // Calls f with each element, after prefetching the object that address
+  // points to for the element distance positions ahead. Stops when f
+  // returns true.
+  template <typename It, typename Address, typename F>
+  inline
+  It
+  for_each_prefetched(
+    It first,
+    It last,
+    const Address& address,
+    std::size_t distance,
+    F&& f)
+  {
+    auto lead = first;
+    for (std::size_t i = 0; i != distance && lead != last; ++i, ++lead)
+    {
+      prefetch(address(*lead));
+    }
+    for (; first != last; ++first)
+    {
+      if (lead != last)
+      {
+        prefetch(address(*lead));
+        ++lead;
+      }
+      if (f(*first)) break;
+    }
+    return first;
+  }
+}
+
+template <typename It, typename Predicate, typename Address>
+inline
+It
+find_if_prefetched(
+  It first,
+  It last,
+  const Predicate& predicate,
+  const Address& address,
+  std::size_t distance = 16)
+{
+  static_assert(std::is_base_of_v<std::forward_iterator_tag,
+                                  typename std::iterator_traits<It>::iterator_category>,
+                "the range is read twice, so it must be a forward range");
+  return detail::for_each_prefetched(first, last, address, distance,
+                                     [&predicate](const auto& v) -> bool {
+                                       return predicate(v);
+                                     });
+}
+
+template <typename It, typename Predicate, typename Address>
+inline
+typename std::iterator_traits<It>::difference_type
+count_if_prefetched(
+  It first,
+  It last,
+  const Predicate& predicate,
+  const Address& address,
+  std::size_t distance = 16)
+{
+  static_assert(std::is_base_of_v<std::forward_iterator_tag,
+                                  typename std::iterator_traits<It>::iterator_category>,
+                "the range is read twice, so it must be a forward range");
+  typename std::iterator_traits<It>::difference_type count = 0;
+  detail::for_each_prefetched(first, last, address, distance,
+                              [&predicate, &count](const auto& v) {
+                                count += predicate(v) ? 1 : 0;
+                                return false;
+                              });
+  return count;
+}
+}
+
+#endif //HIGHER_ORDER_FUNCTIONS_LIFT_PREFETCH_HPP
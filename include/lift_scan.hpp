@@ -0,0 +1,355 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#ifndef HIGHER_ORDER_FUNCTIONS_LIFT_SCAN_HPP
+#define HIGHER_ORDER_FUNCTIONS_LIFT_SCAN_HPP
+
+#include "lift.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lift {
+
+namespace detail
+{
+  [[noreturn]]
+  inline
+  void
+  throw_errno(
+    const std::string& what)
+  {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+
+  class file_descriptor
+  {
+  public:
+    explicit
+    file_descriptor(
+      int fd)
+    noexcept
+      : fd(fd)
+    {
+    }
+
+    file_descriptor(
+      file_descriptor&& f)
+    noexcept
+      : fd(std::exchange(f.fd, -1))
+    {
+    }
+
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    ~file_descriptor()
+    {
+      if (fd >= 0) ::close(fd);
+    }
+
+    int get() const noexcept { return fd; }
+  private:
+    int fd;
+  };
+}
+
+template <typename Record>
+class mmap_file
+{
+  static_assert(std::is_trivially_copyable_v<Record>,
+                "records must be trivially copyable to be read in place");
+public:
+  using value_type = Record;
+  using const_iterator = const Record*;
+
+  explicit
+  mmap_file(
+    const std::string& path)
+  {
+    detail::file_descriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0) detail::throw_errno("open " + path);
+    struct stat st;
+    if (::fstat(fd.get(), &st) != 0) detail::throw_errno("fstat " + path);
+    bytes = static_cast<std::size_t>(st.st_size);
+    if (bytes < sizeof(Record)) return;
+    auto addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (addr == MAP_FAILED) detail::throw_errno("mmap " + path);
+    // only a hint, so failure is not an error
+    (void)::madvise(addr, bytes, MADV_SEQUENTIAL);
+    mapping = addr;
+  }
+
+  mmap_file(
+    mmap_file&& f)
+  noexcept
+    : mapping(std::exchange(f.mapping, nullptr))
+    , bytes(std::exchange(f.bytes, 0))
+  {
+  }
+
+  mmap_file&
+  operator=(
+    mmap_file&& f)
+  noexcept
+  {
+    std::swap(mapping, f.mapping);
+    std::swap(bytes, f.bytes);
+    return *this;
+  }
+
+  ~mmap_file()
+  {
+    if (mapping) ::munmap(mapping, bytes);
+  }
+
+  // A trailing partial record is not part of the file.
+  std::size_t size() const noexcept { return mapping ? bytes / sizeof(Record) : 0; }
+  bool empty() const noexcept { return size() == 0; }
+
+  const Record* begin() const noexcept { return static_cast<const Record*>(mapping); }
+  const Record* end() const noexcept { return begin() + size(); }
+  const Record& operator[](std::size_t i) const noexcept { return begin()[i]; }
+private:
+  void* mapping = nullptr;
+  std::size_t bytes = 0;
+};
+
+namespace detail
+{
+  template <typename Record, typename Chunk>
+  inline
+  void
+  for_each_chunk(
+    const mmap_file<Record>& file,
+    std::size_t threads,
+    Chunk&& chunk)
+  {
+    const auto size = file.size();
+    threads = std::max<std::size_t>(1, std::min(threads, size));
+    if (threads == 1)
+    {
+      chunk(std::size_t{0}, file.begin(), file.end());
+      return;
+    }
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    workers.reserve(threads);
+    for (std::size_t t = 0; t != threads; ++t)
+    {
+      const auto first = size * t / threads;
+      const auto last = size * (t + 1) / threads;
+      workers.emplace_back([&, t, first, last] {
+        try
+        {
+          chunk(t, file.begin() + first, file.begin() + last);
+        }
+        catch (...)
+        {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+    for (auto& e : errors)
+    {
+      if (e) std::rethrow_exception(e);
+    }
+  }
+}
+
+template <typename Record, typename Predicate, typename Action>
+inline
+void
+scan(
+  const mmap_file<Record>& file,
+  const Predicate& predicate,
+  Action&& action,
+  std::size_t threads = 1)
+{
+  detail::for_each_chunk(file, threads,
+    [&](std::size_t, const Record* first, const Record* last) {
+      for (; first != last; ++first)
+      {
+        if (predicate(*first))
+        {
+          action(*first);
+        }
+      }
+    });
+}
+
+namespace detail
+{
+  inline
+  void
+  write_all(
+    int fd,
+    const void* data,
+    std::size_t size,
+    const std::string& path)
+  {
+    auto p = static_cast<const char*>(data);
+    while (size)
+    {
+      const auto n = ::write(fd, p, size);
+      if (n < 0)
+      {
+        if (errno == EINTR) continue;
+        throw_errno("write " + path);
+      }
+      p += n;
+      size -= static_cast<std::size_t>(n);
+    }
+  }
+
+  // An anonymous file next to path, removed when closed.
+  inline
+  file_descriptor
+  temporary_file(
+    const std::string& path)
+  {
+    std::string name = path + ".XXXXXX";
+    file_descriptor fd(::mkstemp(name.data()));
+    if (fd.get() < 0) throw_errno("mkstemp " + name);
+    ::unlink(name.c_str());
+    return fd;
+  }
+
+  inline
+  void
+  append_file(
+    int to,
+    int from,
+    const std::string& path)
+  {
+    if (::lseek(from, 0, SEEK_SET) < 0) throw_errno("lseek " + path);
+    char buffer[64 * 1024];
+    for (;;)
+    {
+      const auto n = ::read(from, buffer, sizeof(buffer));
+      if (n == 0) return;
+      if (n < 0)
+      {
+        if (errno == EINTR) continue;
+        throw_errno("read " + path);
+      }
+      write_all(to, buffer, static_cast<std::size_t>(n), path);
+    }
+  }
+
+  // Writes indexes to a file through a fixed size buffer.
+  class index_writer
+  {
+  public:
+    index_writer(
+      int fd,
+      const std::string& path)
+      : fd(fd)
+      , path(path)
+    {
+    }
+
+    void
+    push(
+      std::uint64_t index)
+    {
+      buffer[used++] = index;
+      if (used == buffer.size()) flush();
+    }
+
+    void
+    flush()
+    {
+      write_all(fd, buffer.data(), used * sizeof(std::uint64_t), path);
+      count += used;
+      used = 0;
+    }
+
+    std::size_t written() const noexcept { return count; }
+  private:
+    int fd;
+    const std::string& path;
+    std::array<std::uint64_t, 4096> buffer;
+    std::size_t used = 0;
+    std::size_t count = 0;
+  };
+}
+
+template <typename Record, typename Predicate>
+inline
+std::size_t
+scan_to_index_file(
+  const mmap_file<Record>& file,
+  const Predicate& predicate,
+  const std::string& index_path,
+  std::size_t threads = 1)
+{
+  detail::file_descriptor fd(::open(index_path.c_str(),
+                                    O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                    0644));
+  if (fd.get() < 0) detail::throw_errno("open " + index_path);
+
+  // The first chunk is written directly to the index file, the others to
+  // temporary files that are appended in order when all are done.
+  threads = std::max<std::size_t>(1, std::min(threads, file.size()));
+  std::vector<detail::file_descriptor> parts;
+  parts.reserve(threads);
+  for (std::size_t t = 1; t < threads; ++t)
+  {
+    parts.push_back(detail::temporary_file(index_path));
+  }
+  std::vector<std::size_t> counts(threads);
+  detail::for_each_chunk(file, threads,
+    [&](std::size_t t, const Record* first, const Record* last) {
+      detail::index_writer out(t == 0 ? fd.get() : parts[t - 1].get(), index_path);
+      for (auto i = first; i != last; ++i)
+      {
+        if (predicate(*i))
+        {
+          out.push(static_cast<std::uint64_t>(i - file.begin()));
+        }
+      }
+      out.flush();
+      counts[t] = out.written();
+    });
+
+  std::size_t count = counts[0];
+  for (std::size_t t = 1; t < threads; ++t)
+  {
+    detail::append_file(fd.get(), parts[t - 1].get(), index_path);
+    count += counts[t];
+  }
+  return count;
+}
+}
+
+#endif //HIGHER_ORDER_FUNCTIONS_LIFT_SCAN_HPP
@@ -0,0 +1,357 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#ifndef HIGHER_ORDER_FUNCTIONS_LIFT_SORT_HPP
+#define HIGHER_ORDER_FUNCTIONS_LIFT_SORT_HPP
+
+#include "lift.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lift {
+
+namespace detail
+{
+  template <typename T, typename = void>
+  struct radix_traits
+  {
+    static_assert(!std::is_same_v<T, T>,
+                  "no order preserving radix key for projected type");
+  };
+
+  template <>
+  struct radix_traits<bool>
+  {
+    using key_type = std::uint8_t;
+    static constexpr bool exact = true;
+
+    static constexpr key_type key(bool b) noexcept { return b; }
+  };
+
+  template <typename T>
+  struct radix_traits<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+  {
+    using key_type = std::make_unsigned_t<T>;
+    static constexpr bool exact = true;
+
+    static constexpr key_type key(T t) noexcept
+    {
+      if constexpr (std::is_signed_v<T>)
+      {
+        // flip the sign bit so that negative values order before positive
+        constexpr auto sign = key_type(key_type(1) << (sizeof(T) * 8 - 1));
+        return key_type(key_type(t) ^ sign);
+      }
+      else
+      {
+        return t;
+      }
+    }
+  };
+
+  template <typename T>
+  struct radix_traits<T, std::enable_if_t<std::is_floating_point_v<T>>>
+  {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                  "only 32 and 64 bit IEEE floating point types are supported");
+    using key_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    static constexpr bool exact = true;
+
+    static key_type key(T t) noexcept
+    {
+      // negative values have all bits flipped, so that larger magnitudes
+      // order first, positive values only get the sign bit set.
+      // -0.0 and +0.0 compare equal, so they must get the same key.
+      constexpr auto sign = key_type(key_type(1) << (sizeof(T) * 8 - 1));
+      if (t == T(0)) t = T(0);
+      key_type bits;
+      std::memcpy(&bits, &t, sizeof(bits));
+      return (bits & sign) ? key_type(~bits) : key_type(bits | sign);
+    }
+  };
+
+  template <typename T>
+  struct radix_traits<T, std::enable_if_t<std::is_enum_v<T>>>
+  {
+    using underlying = radix_traits<std::underlying_type_t<T>>;
+    using key_type = typename underlying::key_type;
+    static constexpr bool exact = true;
+
+    static constexpr key_type key(T t) noexcept
+    {
+      return underlying::key(static_cast<std::underlying_type_t<T>>(t));
+    }
+  };
+
+  template <typename T>
+  struct radix_traits<T, std::enable_if_t<std::is_convertible_v<const T&, std::string_view>
+                                          && !std::is_arithmetic_v<T>>>
+  {
+    // strings are keyed on a big endian packed prefix, so ties between
+    // strings with equal prefixes must be resolved by comparison
+    using key_type = std::uint64_t;
+    static constexpr bool exact = false;
+
+    static constexpr key_type key(const T& t) noexcept
+    {
+      const std::string_view s = t;
+      key_type k = 0;
+      for (std::size_t i = 0; i != sizeof(key_type); ++i)
+      {
+        const auto c = i < s.size() ? static_cast<unsigned char>(s[i]) : 0U;
+        k = key_type((k << 8) | c);
+      }
+      return k;
+    }
+  };
+
+  template <typename P, typename T>
+  using radix_traits_for = radix_traits<std::decay_t<std::invoke_result_t<const P&, const T&>>>;
+
+  template <typename ... Ps>
+  class sort_key
+  {
+  public:
+    constexpr
+    explicit
+    sort_key(
+      Ps ... ps)
+      : projections(std::move(ps)...)
+    {
+    }
+
+    template <typename T>
+    static constexpr bool exact = (radix_traits_for<Ps, T>::exact && ...);
+
+    // The number of leading keys up to and including the last truncated
+    // one. Values whose keys are equal this far need a full comparison.
+    template <typename T>
+    static constexpr std::size_t inexact_prefix = [] {
+      constexpr bool exacts[] = {radix_traits_for<Ps, T>::exact...};
+      std::size_t n = 0;
+      for (std::size_t i = 0; i != sizeof...(Ps); ++i)
+      {
+        if (!exacts[i]) n = i + 1;
+      }
+      return n;
+    }();
+
+    template <typename T>
+    constexpr
+    auto
+    operator()(
+      const T& t)
+    const
+    {
+      return key(t, std::index_sequence_for<Ps...>{});
+    }
+
+    template <typename T>
+    constexpr
+    bool
+    less(
+      const T& lh,
+      const T& rh)
+    const
+    {
+      return less_from<0>(lh, rh);
+    }
+  private:
+    template <typename T, std::size_t ... I>
+    constexpr
+    auto
+    key(
+      const T& t,
+      std::index_sequence<I...>)
+    const
+    {
+      return std::tuple(radix_traits_for<Ps, T>::key(std::get<I>(projections)(t))...);
+    }
+
+    template <std::size_t I, typename T>
+    constexpr
+    bool
+    less_from(
+      const T& lh,
+      const T& rh)
+    const
+    {
+      if constexpr (I == sizeof...(Ps))
+      {
+        return false;
+      }
+      else
+      {
+        using traits = radix_traits_for<std::tuple_element_t<I, std::tuple<Ps...>>, T>;
+        const auto& p = std::get<I>(projections);
+        const auto& l = p(lh);
+        const auto& r = p(rh);
+        if constexpr (traits::exact)
+        {
+          if (l < r) return true;
+          if (r < l) return false;
+        }
+        else
+        {
+          // compare by content, also for projections to const char*
+          const auto c = std::string_view(l).compare(std::string_view(r));
+          if (c != 0) return c < 0;
+        }
+        return less_from<I + 1>(lh, rh);
+      }
+    }
+
+    std::tuple<Ps...> projections;
+  };
+
+  template <std::size_t I, typename Entry>
+  void
+  radix_passes(
+    std::vector<Entry>& from,
+    std::vector<Entry>& to)
+  {
+    using key_type = std::tuple_element_t<I, decltype(Entry::key)>;
+    for (unsigned shift = 0; shift != sizeof(key_type) * 8; shift += 8)
+    {
+      const auto byte = [shift](const Entry& e) {
+        return std::size_t((std::get<I>(e.key) >> shift) & 0xffU);
+      };
+      std::array<std::size_t, 256> offsets{};
+      for (const auto& e : from)
+      {
+        ++offsets[byte(e)];
+      }
+      if (offsets[byte(from.front())] == from.size())
+      {
+        continue; // all entries share this byte, the pass would be a no-op
+      }
+      std::size_t sum = 0;
+      for (auto& o : offsets)
+      {
+        sum += std::exchange(o, sum);
+      }
+      for (auto& e : from)
+      {
+        to[offsets[byte(e)]++] = std::move(e);
+      }
+      from.swap(to);
+    }
+  }
+
+  template <typename Key, std::size_t ... I>
+  inline
+  constexpr
+  bool
+  key_prefix_equal(
+    const Key& lh,
+    const Key& rh,
+    std::index_sequence<I...>)
+  {
+    return ((std::get<I>(lh) == std::get<I>(rh)) && ...);
+  }
+
+  template <typename Entry, std::size_t ... I>
+  void
+  radix_sort(
+    std::vector<Entry>& from,
+    std::vector<Entry>& to,
+    std::index_sequence<I...>)
+  {
+    // least significant projection first
+    (radix_passes<sizeof...(I) - 1 - I>(from, to), ...);
+  }
+}
+
+template <typename ... Ps>
+inline
+constexpr
+auto
+sort_key(
+  Ps&& ... ps)
+{
+  return detail::sort_key<std::decay_t<Ps>...>(std::forward<Ps>(ps)...);
+}
+
+template <typename RandomIt, typename ... Ps>
+inline
+void
+radix_sort(
+  RandomIt first,
+  RandomIt last,
+  const detail::sort_key<Ps...>& key)
+{
+  using value_type = typename std::iterator_traits<RandomIt>::value_type;
+  using key_type = decltype(key(*first));
+  struct entry {
+    key_type key;
+    std::size_t index;
+  };
+
+  const auto size = static_cast<std::size_t>(std::distance(first, last));
+  if (size < 2) return;
+
+  std::vector<entry> entries;
+  entries.reserve(size);
+  for (std::size_t i = 0; i != size; ++i)
+  {
+    entries.push_back(entry{key(first[i]), i});
+  }
+  std::vector<entry> scratch(size);
+  detail::radix_sort(entries, scratch, std::index_sequence_for<Ps...>{});
+
+  std::vector<value_type> sorted;
+  sorted.reserve(size);
+  for (const auto& e : entries)
+  {
+    sorted.push_back(std::move(first[e.index]));
+  }
+  std::move(sorted.begin(), sorted.end(), first);
+
+  if constexpr (!detail::sort_key<Ps...>::template exact<value_type>)
+  {
+    // Later keys must not split runs of equal truncated keys, since the
+    // full comparison may order the run differently.
+    using prefix = std::make_index_sequence<detail::sort_key<Ps...>::template inexact_prefix<value_type>>;
+    const auto less = [&key](const value_type& lh, const value_type& rh) {
+      return key.less(lh, rh);
+    };
+    std::size_t begin = 0;
+    while (begin != size)
+    {
+      std::size_t end = begin + 1;
+      while (end != size
+             && detail::key_prefix_equal(entries[end].key, entries[begin].key, prefix{}))
+      {
+        ++end;
+      }
+      if (end - begin > 1)
+      {
+        std::stable_sort(first + begin, first + end, less);
+      }
+      begin = end;
+    }
+  }
+}
+}
+
+#endif //HIGHER_ORDER_FUNCTIONS_LIFT_SORT_HPP
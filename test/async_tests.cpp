@@ -0,0 +1,238 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#include <lift_async.hpp>
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Resumes suspended coroutines from a thread of its own, in the order
+// they were suspended, like a completion queue for I/O. Completions are
+// held back until `batch` operations are pending, or for a short while.
+class io_thread
+{
+public:
+  explicit
+  io_thread(
+    std::size_t batch = 1)
+    : batch(batch)
+    , thread([this] { run(); })
+  {
+  }
+
+  ~io_thread()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    cond.notify_one();
+    thread.join();
+  }
+
+  void
+  post(
+    std::coroutine_handle<> h)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(h);
+    }
+    cond.notify_one();
+  }
+private:
+  void
+  run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+      cond.wait(lock, [this] { return stop || !queue.empty(); });
+      if (queue.empty()) return;
+      cond.wait_for(lock, std::chrono::milliseconds(10),
+                    [this] { return stop || queue.size() >= batch; });
+      auto ready = std::move(queue);
+      queue.clear();
+      lock.unlock();
+      for (auto h : ready)
+      {
+        h.resume();
+      }
+      lock.lock();
+    }
+  }
+
+  const std::size_t batch;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::coroutine_handle<>> queue;
+  bool stop = false;
+  std::thread thread;
+};
+
+// An in memory blob store whose reads complete on the io_thread.
+class mock_store
+{
+public:
+  explicit
+  mock_store(
+    io_thread& io)
+    : io(io)
+  {
+  }
+
+  struct read_op
+  {
+    bool await_ready() const noexcept { return false; }
+
+    void
+    await_suspend(
+      std::coroutine_handle<> h)
+    {
+      const auto n = ++store.in_flight;
+      auto max = store.max_in_flight.load();
+      while (n > max && !store.max_in_flight.compare_exchange_weak(max, n))
+      {
+      }
+      store.io.post(h);
+    }
+
+    std::string
+    await_resume()
+    {
+      --store.in_flight;
+      const auto i = store.blobs.find(key);
+      if (i == store.blobs.end()) throw std::out_of_range(key);
+      return i->second;
+    }
+
+    mock_store& store;
+    std::string key;
+  };
+
+  read_op read(std::string key) { return {*this, std::move(key)}; }
+
+  std::map<std::string, std::string> blobs;
+  std::atomic<int> in_flight{0};
+  std::atomic<int> max_in_flight{0};
+private:
+  io_thread& io;
+};
+
+}
+
+TEST_CASE("compose_async")
+{
+  io_thread io;
+  mock_store store(io);
+  store.blobs = {{"a", "aaa"}, {"b", "bbbbb"}};
+  auto read = [&store](const std::string& key) { return store.read(key); };
+  auto length = [](const std::string& s) { return s.length(); };
+  auto twice = [](std::size_t n) { return n * 2; };
+  WHEN("all stages are synchronous")
+  {
+    auto f = lift::compose_async(twice, length);
+    THEN("the result is that of compose")
+    {
+      REQUIRE(lift::sync_wait(f(std::string("abc"))) == 6U);
+    }
+  }
+  AND_WHEN("a stage returns an awaitable")
+  {
+    auto f = lift::compose_async(twice, length, read);
+    THEN("it is awaited and its result passed to the next stage")
+    {
+      REQUIRE(lift::sync_wait(f(std::string("b"))) == 10U);
+    }
+  }
+  AND_WHEN("several stages return awaitables")
+  {
+    auto f = lift::compose_async(length, read, [](std::string s) { return s.substr(0, 1); }, read);
+    THEN("they are all awaited in turn")
+    {
+      REQUIRE(lift::sync_wait(f(std::string("b"))) == 5U);
+    }
+  }
+  AND_WHEN("the composed function is destroyed before the task is awaited")
+  {
+    auto t = lift::compose_async(twice, length, read)(std::string("a"));
+    THEN("the task still has its stages")
+    {
+      REQUIRE(lift::sync_wait(std::move(t)) == 6U);
+    }
+  }
+  AND_WHEN("an awaited stage throws")
+  {
+    auto f = lift::compose_async(length, read);
+    THEN("the exception is propagated to the awaiter")
+    {
+      REQUIRE_THROWS_AS(lift::sync_wait(f(std::string("c"))), std::out_of_range);
+    }
+  }
+}
+
+TEST_CASE("for_each_async")
+{
+  io_thread io(8);
+  mock_store store(io);
+  std::vector<std::string> keys;
+  for (int i = 0; i != 100; ++i)
+  {
+    keys.push_back(std::to_string(i));
+    store.blobs[keys.back()] = std::string(std::size_t(i), 'x');
+  }
+  auto f = lift::compose_async([](const std::string& s) { return s.length(); },
+                               [&store](const std::string& key) { return store.read(key); });
+  WHEN("run with a window of 8 items")
+  {
+    std::vector<std::size_t> results;
+    lift::sync_wait(lift::for_each_async(keys.begin(), keys.end(), f,
+                                         [&](std::size_t n) { results.push_back(n); },
+                                         8));
+    THEN("all items are processed")
+    {
+      std::sort(results.begin(), results.end());
+      std::vector<std::size_t> expected(100);
+      for (std::size_t i = 0; i != expected.size(); ++i) expected[i] = i;
+      REQUIRE(results == expected);
+    }
+    AND_THEN("no more than 8 items were in flight at once")
+    {
+      REQUIRE(store.max_in_flight == 8);
+    }
+  }
+  AND_WHEN("an item fails")
+  {
+    keys.push_back("missing");
+    auto run = lift::for_each_async(keys.begin(), keys.end(), f,
+                                    [](std::size_t) {},
+                                    4);
+    THEN("the exception is propagated once all in flight items are done")
+    {
+      REQUIRE_THROWS_AS(lift::sync_wait(std::move(run)), std::out_of_range);
+    }
+  }
+}
@@ -0,0 +1,84 @@
+# Compares the disassembly of the lift_<name> and hand_<name> functions in
+# OBJECT, as disassembled by OBJDUMP, and fails if a lift version uses
+# more than TOLERANCE instructions more than the hand written version, or
+# calls functions or accesses the stack when the hand written one does not.
+
+if (NOT OBJDUMP OR NOT OBJECT)
+    message(FATAL_ERROR "usage: cmake -DOBJDUMP=<objdump> -DOBJECT=<file.o> [-DTOLERANCE=<n>] -P check_codegen.cmake")
+endif()
+if (NOT DEFINED TOLERANCE)
+    set(TOLERANCE 0)
+endif()
+
+execute_process(
+        COMMAND ${OBJDUMP} -d --no-show-raw-insn ${OBJECT}
+        OUTPUT_VARIABLE disassembly
+        RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}")
+endif()
+
+string(REPLACE ";" "\;" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(functions)
+set(current)
+foreach(line IN LISTS lines)
+    if (line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_]+)>:$")
+        set(current ${CMAKE_MATCH_1})
+        list(APPEND functions ${current})
+        set(${current}_instructions 0)
+        set(${current}_calls 0)
+        set(${current}_stack 0)
+    elseif (current AND line MATCHES "^ +[0-9a-f]+:\t([a-z][a-z0-9.]*)(.*)$")
+        set(mnemonic ${CMAKE_MATCH_1})
+        set(operands "${CMAKE_MATCH_2}")
+        if (mnemonic MATCHES "^(nop|xchg|data16|cs|int3)")
+            continue() # alignment padding
+        endif()
+        math(EXPR ${current}_instructions "${${current}_instructions} + 1")
+        if (mnemonic MATCHES "^call")
+            math(EXPR ${current}_calls "${${current}_calls} + 1")
+        endif()
+        if (mnemonic MATCHES "^(push|pop)" OR operands MATCHES "%[re]?sp")
+            math(EXPR ${current}_stack "${${current}_stack} + 1")
+        endif()
+    endif()
+endforeach()
+
+set(failures)
+set(pairs 0)
+foreach(function IN LISTS functions)
+    if (NOT function MATCHES "^lift_(.+)$")
+        continue()
+    endif()
+    set(hand hand_${CMAKE_MATCH_1})
+    if (NOT DEFINED ${hand}_instructions)
+        list(APPEND failures "${function}: no ${hand} to compare with")
+        continue()
+    endif()
+    math(EXPR pairs "${pairs} + 1")
+    set(lift_count ${${function}_instructions})
+    set(hand_count ${${hand}_instructions})
+    message(STATUS "${function}: ${lift_count} instructions, ${hand}: ${hand_count}")
+    math(EXPR limit "${hand_count} + ${TOLERANCE}")
+    if (lift_count GREATER limit)
+        list(APPEND failures "${function}: ${lift_count} instructions, ${hand}: ${hand_count}")
+    endif()
+    if (${function}_calls GREATER ${hand}_calls)
+        list(APPEND failures "${function}: ${${function}_calls} calls, ${hand}: ${${hand}_calls}")
+    endif()
+    if (${function}_stack GREATER ${hand}_stack)
+        list(APPEND failures "${function}: ${${function}_stack} stack accesses, ${hand}: ${${hand}_stack}")
+    endif()
+endforeach()
+
+if (pairs EQUAL 0)
+    list(APPEND failures "no lift_<name> functions found in ${OBJECT}")
+endif()
+
+if (failures)
+    string(REPLACE ";" "\n  " failures "${failures}")
+    message(FATAL_ERROR "lift generates worse code than hand written equivalents:\n  ${failures}")
+endif()
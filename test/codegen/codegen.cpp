@@ -0,0 +1,137 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+// Pairs of functions, lift_<name> using lift, and hand_<name> written
+// out by hand. check_codegen.cmake fails the build if any lift_<name> is
+// compiled to more instructions than hand_<name>, or makes calls or
+// touches the stack when hand_<name> does not.
+
+#include <lift.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace {
+
+struct record
+{
+  int key;
+  int value;
+};
+
+constexpr auto select_key = [](const record& r) { return r.key; };
+constexpr auto select_value = [](const record& r) { return r.value; };
+
+inline int twice(int x) { return x * 2; }
+inline double twice(double x) { return x * 2; }
+
+}
+
+extern "C" {
+
+bool lift_compose(const record& r)
+{
+  return lift::compose(lift::equal(5), select_value)(r);
+}
+
+bool hand_compose(const record& r)
+{
+  return r.value == 5;
+}
+
+bool lift_compose_binary(const record& l, const record& r)
+{
+  return lift::compose(std::less<>{}, select_key)(l, r);
+}
+
+bool hand_compose_binary(const record& l, const record& r)
+{
+  return l.key < r.key;
+}
+
+bool lift_negate(int x)
+{
+  return lift::negate(lift::equal(3))(x);
+}
+
+bool hand_negate(int x)
+{
+  return !(x == 3);
+}
+
+bool lift_when_all(int x)
+{
+  return lift::when_all(lift::greater_than(0), lift::less_than(10), lift::not_equal(5))(x);
+}
+
+bool hand_when_all(int x)
+{
+  return x > 0 && x < 10 && x != 5;
+}
+
+bool lift_when_any(const record& r)
+{
+  return lift::when_any(lift::compose(lift::equal(1), select_key),
+                        lift::compose(lift::less_than(0), select_value))(r);
+}
+
+bool hand_when_any(const record& r)
+{
+  return r.key == 1 || r.value < 0;
+}
+
+int lift_if_then_else(int x)
+{
+  return lift::if_then_else(lift::less_than(0),
+                            std::negate<>{},
+                            [](int i) { return i; })(x);
+}
+
+int hand_if_then_else(int x)
+{
+  return x < 0 ? -x : x;
+}
+
+int lift_function(int x)
+{
+  return lift::compose(LIFT_FUNCTION(twice), LIFT_FUNCTION(twice))(x);
+}
+
+int hand_function(int x)
+{
+  return twice(twice(x));
+}
+
+std::size_t lift_count_if(const record* first, const record* last)
+{
+  const auto pred = lift::when_all(lift::compose(lift::greater_than(0), select_key),
+                                   lift::compose(lift::less_than(100), select_value));
+  std::size_t n = 0;
+  for (; first != last; ++first)
+  {
+    n += pred(*first);
+  }
+  return n;
+}
+
+std::size_t hand_count_if(const record* first, const record* last)
+{
+  std::size_t n = 0;
+  for (; first != last; ++first)
+  {
+    n += first->key > 0 && first->value < 100;
+  }
+  return n;
+}
+
+}
@@ -0,0 +1,209 @@
+/*
+ * lift C++ higher order convenience functions
+ *
+ * Copyright © Björn Fahller 2017,2018
+ *
+ *  Use, modification and distribution is subject to the
+ *  Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at
+ *  http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Project home: https://github.com/rollbear/lift
+ */
+
+#include <lift_scan.hpp>
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+struct record
+{
+  std::uint32_t id;
+  std::int32_t  value;
+  double        weight;
+};
+
+constexpr auto select_id = [](const record& r) { return r.id; };
+constexpr auto select_value = [](const record& r) { return r.value; };
+
+// A uniquely named, initially empty, file in the temporary directory,
+// which is removed when its owner is destroyed.
+class temp_file
+{
+public:
+  temp_file()
+  {
+    auto name = (std::filesystem::temp_directory_path() / "lift_scan_test_XXXXXX").string();
+    const int fd = ::mkstemp(name.data());
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "mkstemp");
+    ::close(fd);
+    path = std::move(name);
+  }
+
+  temp_file(
+    temp_file&& f)
+  noexcept
+    : path(std::exchange(f.path, std::string{}))
+  {
+  }
+
+  temp_file& operator=(const temp_file&) = delete;
+
+  ~temp_file()
+  {
+    if (!path.empty()) std::remove(path.c_str());
+  }
+
+  std::string path;
+};
+
+temp_file
+write_records(
+  std::size_t count,
+  std::size_t trailing_bytes = 0)
+{
+  temp_file f;
+  std::ofstream os(f.path, std::ios::binary);
+  for (std::uint32_t i = 0; i != count; ++i)
+  {
+    const record r{i, std::int32_t(i % 100) - 50, i * 0.5};
+    os.write(reinterpret_cast<const char*>(&r), sizeof(r));
+  }
+  os.write("garbage", std::streamsize(trailing_bytes));
+  return f;
+}
+
+}
+
+TEST_CASE("mmap_file")
+{
+  WHEN("the file has a trailing partial record")
+  {
+    auto f = write_records(10, 3);
+    lift::mmap_file<record> file(f.path);
+    THEN("only the whole records are visible")
+    {
+      REQUIRE(file.size() == 10U);
+      REQUIRE(file[9].id == 9U);
+    }
+  }
+  AND_WHEN("the file is empty")
+  {
+    auto f = write_records(0);
+    lift::mmap_file<record> file(f.path);
+    THEN("it has no records")
+    {
+      REQUIRE(file.empty());
+      REQUIRE(file.begin() == file.end());
+    }
+  }
+  AND_WHEN("the file does not exist")
+  {
+    THEN("a system_error is thrown")
+    {
+      REQUIRE_THROWS_AS(lift::mmap_file<record>("no/such/file"), std::system_error);
+    }
+  }
+}
+
+TEST_CASE("scan")
+{
+  auto f = write_records(10000);
+  lift::mmap_file<record> file(f.path);
+  const auto pred = lift::when_all(lift::compose(lift::greater_than(0), select_value),
+                                   lift::when_any(lift::compose(lift::less_than(1000U), select_id),
+                                                  lift::compose(lift::equal(9999U), select_id)));
+  std::vector<std::uint32_t> expected;
+  for (const auto& r : file)
+  {
+    if (pred(r)) expected.push_back(r.id);
+  }
+  REQUIRE(!expected.empty());
+
+  WHEN("scanning sequentially")
+  {
+    std::vector<std::uint32_t> ids;
+    lift::scan(file, pred, [&](const record& r) { ids.push_back(r.id); });
+    THEN("the action is called in order for the matching records")
+    {
+      REQUIRE(ids == expected);
+    }
+  }
+  AND_WHEN("scanning in parallel")
+  {
+    std::mutex mutex;
+    std::vector<std::uint32_t> ids;
+    lift::scan(file, pred,
+               [&](const record& r) {
+                 std::lock_guard<std::mutex> lock(mutex);
+                 ids.push_back(r.id);
+               },
+               4);
+    THEN("the action is called for all matching records")
+    {
+      std::sort(ids.begin(), ids.end());
+      REQUIRE(ids == expected);
+    }
+    AND_THEN("the records are referred to in place")
+    {
+      std::atomic<bool> in_place{true};
+      lift::scan(file, pred,
+                 [&](const record& r) {
+                   if (&r < file.begin() || &r >= file.end()) in_place = false;
+                 },
+                 4);
+      REQUIRE(in_place);
+    }
+  }
+  AND_WHEN("writing a selection index file")
+  {
+    temp_file index;
+    const auto count = lift::scan_to_index_file(file, pred, index.path, 3);
+    THEN("the file holds the indexes of the matching records in order")
+    {
+      REQUIRE(count == expected.size());
+      std::ifstream is(index.path, std::ios::binary);
+      std::vector<std::uint64_t> indexes(count);
+      is.read(reinterpret_cast<char*>(indexes.data()),
+              std::streamsize(count * sizeof(std::uint64_t)));
+      REQUIRE(is.gcount() == std::streamsize(count * sizeof(std::uint64_t)));
+      REQUIRE(std::equal(indexes.begin(), indexes.end(), expected.begin(), expected.end()));
+    }
+  }
+  AND_WHEN("selecting more indexes than are buffered at a time")
+  {
+    temp_file index;
+    const auto count = lift::scan_to_index_file(file, [](const record&) { return true; },
+                                                index.path, 3);
+    THEN("all indexes are written in order")
+    {
+      REQUIRE(count == file.size());
+      std::ifstream is(index.path, std::ios::binary);
+      std::vector<std::uint64_t> indexes(count);
+      is.read(reinterpret_cast<char*>(indexes.data()),
+              std::streamsize(count * sizeof(std::uint64_t)));
+      REQUIRE(is.gcount() == std::streamsize(count * sizeof(std::uint64_t)));
+      std::vector<std::uint64_t> expected_indexes(count);
+      std::iota(expected_indexes.begin(), expected_indexes.end(), std::uint64_t{0});
+      REQUIRE(indexes == expected_indexes);
+    }
+  }
+}
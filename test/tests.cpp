@@ -12,8 +12,18 @@
  */
 
 #include <lift.hpp>
+#include <lift_lexicographic.hpp>
+#include <lift_prefetch.hpp>
+#include <lift_sort.hpp>
 #include <catch.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
 // constexpr tests
 
 template <auto N>
@@ -47,6 +57,24 @@ static_assert(lift::compose(gt<2>,
                             std::plus<>{})(1,2),
               "compose is constexpr");
 
+static_assert(lift::cost<5>(eq<3>)(3),
+              "cost is constexpr");
+static_assert(decltype(lift::cost<5>(eq<3>))::cost == 5,
+              "cost is kept in the type");
+static_assert(decltype(lift::equal(3))::cost < lift::default_cost,
+              "comparisons are cheap");
+static_assert(decltype(lift::negate(lift::equal(3)))::cost == 1,
+              "negate keeps the cost");
+static_assert(decltype(lift::compose(lift::equal(3), std::negate<>{}))::cost
+              == 1 + lift::default_cost,
+              "compose sums the costs");
+static_assert(decltype(lift::compose(lift::equal(3), lift::cost<2>(std::negate<>{})))::cost
+              == 3,
+              "compose sums the costs");
+
+static_assert(lift::lexicographic(std::negate<>{})(2, 1),
+              "lexicographic is constexpr");
+
 template <typename T, typename = std::enable_if_t<std::is_same<T, bool>{}>>
 bool func(T);
 
@@ -192,6 +220,79 @@ TEST_CASE("when_all")
   }
 }
 
+TEST_CASE("when_all with costs")
+{
+  std::string order;
+  auto pred = [&order](char name) {
+    return [&order, name](int) { order += name; return true; };
+  };
+  WHEN("predicates have different costs")
+  {
+    REQUIRE(lift::when_all(lift::cost<30>(pred('a')),
+                           lift::cost<10>(pred('b')),
+                           lift::cost<20>(pred('c')))(0));
+    THEN("they are called in order of increasing cost")
+    {
+      REQUIRE(order == "bca");
+    }
+  }
+  AND_WHEN("predicates have the same cost")
+  {
+    REQUIRE(lift::when_all(lift::cost<10>(pred('a')),
+                           pred('b'),
+                           lift::cost<10>(pred('c')),
+                           pred('d'))(0));
+    THEN("they keep their order")
+    {
+      REQUIRE(order == "acbd");
+    }
+  }
+  AND_WHEN("a cheap predicate is false")
+  {
+    auto expensive = [&order](int) { order += 'x'; return true; };
+    REQUIRE_FALSE(lift::when_all(expensive, lift::equal(3))(4));
+    THEN("the expensive predicate is not called")
+    {
+      REQUIRE(order.empty());
+    }
+  }
+  AND_WHEN("a cheap predicate is composed with a projection")
+  {
+    auto expensive = lift::cost<1000>([&order](int) { order += 'x'; return true; });
+    auto twice = [](int i) { return i * 2; };
+    REQUIRE_FALSE(lift::when_all(expensive, lift::compose(lift::equal(6), twice))(4));
+    THEN("the composition is cheaper and the expensive predicate is not called")
+    {
+      REQUIRE(order.empty());
+    }
+  }
+  AND_WHEN("an unannotated guard precedes a composition with a projection")
+  {
+    auto not_null = [](const int* p) { return p != nullptr; };
+    auto deref = [](const int* p) { return *p; };
+    int three = 3;
+    THEN("the guard is called first")
+    {
+      REQUIRE_FALSE(lift::when_all(not_null, lift::compose(lift::equal(3), deref))(nullptr));
+      REQUIRE(lift::when_all(not_null, lift::compose(lift::equal(3), deref))(&three));
+    }
+  }
+  AND_WHEN("a predicate has a data member named cost")
+  {
+    struct cheaper_than
+    {
+      int cost;
+      bool operator()(int i) const { return i < cost; }
+    };
+    THEN("it is not mistaken for a cost annotation")
+    {
+      REQUIRE(lift::when_all(cheaper_than{5}, lift::equal(3))(3));
+      REQUIRE_FALSE(lift::when_all(cheaper_than{5}, lift::equal(3))(4));
+      REQUIRE_FALSE(lift::when_all(cheaper_than{2}, lift::equal(3))(3));
+    }
+  }
+}
+
 TEST_CASE("when_any")
 {
   WHEN("all predicates are false")
@@ -294,6 +395,33 @@ TEST_CASE("when_none")
   }
 }
 
+TEST_CASE("when_any with costs")
+{
+  std::string order;
+  auto pred = [&order](char name) {
+    return [&order, name](int) { order += name; return false; };
+  };
+  WHEN("predicates have different costs")
+  {
+    REQUIRE_FALSE(lift::when_any(lift::cost<30>(pred('a')),
+                                 lift::cost<10>(pred('b')),
+                                 pred('c'))(0));
+    THEN("they are called in order of increasing cost")
+    {
+      REQUIRE(order == "bac");
+    }
+  }
+  AND_WHEN("a cheap predicate is true")
+  {
+    auto expensive = [&order](int) { order += 'x'; return false; };
+    REQUIRE(lift::when_any(expensive, lift::less_than(5))(4));
+    THEN("the expensive predicate is not called")
+    {
+      REQUIRE(order.empty());
+    }
+  }
+}
+
 TEST_CASE("if_then")
 {
   WHEN("predicate is true")
@@ -425,4 +553,246 @@ TEST_CASE("LIFT macro")
 {
   REQUIRE(equal_to_string("3")(3));
   REQUIRE(equal_to_string("3")("3"));
-}
\ No newline at end of file
+}
+
+TEST_CASE("lexicographic")
+{
+  struct record {
+    std::string name;
+    int         age;
+    double      score;
+  };
+  auto name = [](const record& r) -> const std::string& { return r.name; };
+  auto age = [](const record& r) { return r.age; };
+  auto score = [](const record& r) { return r.score; };
+  WHEN("called with projections only")
+  {
+    auto less = lift::lexicographic(name, age);
+    THEN("they are compared in ascending order, first key first")
+    {
+      REQUIRE(less(record{"a", 5, 0}, record{"b", 1, 0}));
+      REQUIRE(!less(record{"b", 1, 0}, record{"a", 5, 0}));
+      REQUIRE(less(record{"a", 1, 0}, record{"a", 5, 0}));
+      REQUIRE(!less(record{"a", 5, 0}, record{"a", 5, 0}));
+    }
+  }
+  AND_WHEN("a key is descending")
+  {
+    auto less = lift::lexicographic(lift::descending(age), name);
+    THEN("that key is compared in reverse order")
+    {
+      REQUIRE(less(record{"b", 5, 0}, record{"a", 1, 0}));
+      REQUIRE(less(record{"a", 5, 0}, record{"b", 5, 0}));
+    }
+  }
+  AND_WHEN("a key has its own comparator")
+  {
+    auto by_length = [](const std::string& l, const std::string& r) {
+      return l.length() < r.length();
+    };
+    auto less = lift::lexicographic(lift::ascending(name, by_length), score);
+    THEN("the comparator is used for that key")
+    {
+      REQUIRE(less(record{"zz", 0, 2.0}, record{"aaa", 0, 1.0}));
+      REQUIRE(less(record{"zz", 0, 1.0}, record{"aa", 0, 2.0}));
+    }
+  }
+  AND_WHEN("a key has a three-way comparator")
+  {
+    auto cmp = [](int l, int r) { return r - l; };
+    auto less = lift::lexicographic(lift::ascending(age, lift::three_way(cmp)), name);
+    THEN("its sign decides the order")
+    {
+      REQUIRE(less(record{"a", 5, 0}, record{"a", 1, 0}));
+      REQUIRE(less(record{"a", 1, 0}, record{"b", 1, 0}));
+    }
+  }
+  AND_WHEN("a key has a less than predicate that returns int")
+  {
+    auto cmp = [](int l, int r) -> int { return l < r; };
+    auto less = lift::lexicographic(lift::ascending(age, cmp), name);
+    THEN("it is not mistaken for a three-way comparator")
+    {
+      REQUIRE(less(record{"a", 1, 0}, record{"a", 5, 0}));
+      REQUIRE(!less(record{"a", 5, 0}, record{"a", 1, 0}));
+      REQUIRE(less(record{"a", 1, 0}, record{"b", 1, 0}));
+    }
+  }
+  AND_WHEN("the first key differs")
+  {
+    int calls = 0;
+    auto counted_age = [&calls](const record& r) { ++calls; return r.age; };
+    auto less = lift::lexicographic(name, counted_age);
+    THEN("the later keys are not projected")
+    {
+      REQUIRE(less(record{"a", 5, 0}, record{"b", 1, 0}));
+      REQUIRE(calls == 0);
+    }
+  }
+}
+
+TEST_CASE("sort_key")
+{
+  WHEN("projecting signed integers")
+  {
+    auto key = lift::sort_key([](int i) { return i; });
+    THEN("the keys preserve the order of the values")
+    {
+      REQUIRE(key(-5) < key(-1));
+      REQUIRE(key(-1) < key(0));
+      REQUIRE(key(0) < key(7));
+    }
+  }
+  AND_WHEN("projecting floating point values")
+  {
+    auto key = lift::sort_key([](double d) { return d; });
+    THEN("the keys preserve the order of the values")
+    {
+      REQUIRE(key(-1e10) < key(-1.5));
+      REQUIRE(key(-1.5) < key(-0.25));
+      REQUIRE(key(-0.25) < key(0.0));
+      REQUIRE(key(0.0) < key(1e-300));
+      REQUIRE(key(1e-300) < key(3.0));
+    }
+    AND_THEN("negative and positive zero have the same key")
+    {
+      REQUIRE(key(-0.0) == key(0.0));
+    }
+  }
+  AND_WHEN("copying a key")
+  {
+    auto key = lift::sort_key([](int i) { return i; });
+    decltype(key) copy(key);
+    auto captured = [key] { return key(3); };
+    THEN("the copies give the same keys")
+    {
+      REQUIRE(copy(3) == key(3));
+      REQUIRE(captured() == key(3));
+    }
+  }
+  AND_WHEN("projecting strings")
+  {
+    auto key = lift::sort_key([](const std::string& s) -> const std::string& { return s; });
+    THEN("the keys are order preserving prefixes")
+    {
+      REQUIRE(key(std::string("abc")) < key(std::string("abd")));
+      REQUIRE(key(std::string("ab")) < key(std::string("abc")));
+      REQUIRE(key(std::string("abcdefghX")) == key(std::string("abcdefghY")));
+    }
+  }
+}
+
+TEST_CASE("radix_sort")
+{
+  WHEN("sorting integers")
+  {
+    std::vector<int> v{5, -3, 100000, 0, -70000, 42, 5, -1};
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+    lift::radix_sort(v.begin(), v.end(), lift::sort_key([](int i) { return i; }));
+    THEN("they are sorted in ascending order")
+    {
+      REQUIRE(v == expected);
+    }
+  }
+  AND_WHEN("sorting on several projections")
+  {
+    using P = std::pair<std::string, float>;
+    std::vector<P> v{
+      {"banana", 2.0f}, {"apple", -1.0f}, {"banana", -3.5f}, {"apple", 0.5f},
+      {"a_long_common_prefix_2", 1.0f}, {"a_long_common_prefix_1", 1.0f}
+    };
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+    lift::radix_sort(v.begin(), v.end(),
+                     lift::sort_key([](const P& p) -> const std::string& { return p.first; },
+                                    [](const P& p) { return p.second; }));
+    THEN("they are ordered by the first projection, then the next")
+    {
+      REQUIRE(v == expected);
+    }
+  }
+  AND_WHEN("strings share a truncated prefix but differ in a later key")
+  {
+    using P = std::pair<std::string, int>;
+    std::vector<P> v{{"abcdefgh_2", 0}, {"abcdefgh_1", 1}, {"abcdefgh_1", 0}, {"abc", 5}};
+    lift::radix_sort(v.begin(), v.end(),
+                     lift::sort_key([](const P& p) -> const std::string& { return p.first; },
+                                    [](const P& p) { return p.second; }));
+    THEN("the full strings decide the order before the later key")
+    {
+      REQUIRE(v == std::vector<P>{{"abc", 5}, {"abcdefgh_1", 0}, {"abcdefgh_1", 1}, {"abcdefgh_2", 0}});
+    }
+  }
+  AND_WHEN("strings are projected as const char* sharing a truncated prefix")
+  {
+    const char buffer[] = "abcdefgh_b\0abcdefgh_a";
+    // the lower address holds the greater string
+    std::vector<const char*> v{buffer, buffer + 11};
+    lift::radix_sort(v.begin(), v.end(),
+                     lift::sort_key([](const char* s) { return s; }));
+    THEN("they are ordered by content, not by address")
+    {
+      REQUIRE(std::string(v[0]) == "abcdefgh_a");
+      REQUIRE(std::string(v[1]) == "abcdefgh_b");
+    }
+  }
+  AND_WHEN("elements have equal keys")
+  {
+    using P = std::pair<int, int>;
+    std::vector<P> v{{2, 0}, {1, 1}, {2, 2}, {1, 3}, {2, 4}};
+    lift::radix_sort(v.begin(), v.end(),
+                     lift::sort_key([](const P& p) { return p.first; }));
+    THEN("the sort is stable")
+    {
+      REQUIRE(v == std::vector<P>{{1, 1}, {1, 3}, {2, 0}, {2, 2}, {2, 4}});
+    }
+  }
+}
+
+TEST_CASE("count_if_prefetched and find_if_prefetched")
+{
+  struct owner { int id; };
+  struct item { const owner* o; };
+  std::vector<owner> owners{{1}, {2}, {3}, {2}};
+  std::vector<item> items;
+  for (int i = 0; i != 40; ++i)
+  {
+    items.push_back({&owners[std::size_t(i) % owners.size()]});
+  }
+  auto select_owner = [](const item& i) { return i.o; };
+  auto select_owner_id = [](const item& i) { return i.o->id; };
+  auto owned_by_2 = lift::compose(lift::equal(2), select_owner_id);
+  WHEN("counting")
+  {
+    THEN("the result is that of count_if, for any distance")
+    {
+      const auto expected = std::count_if(items.begin(), items.end(), owned_by_2);
+      REQUIRE(expected == 20);
+      for (std::size_t d : {0U, 1U, 16U, 100U})
+      {
+        REQUIRE(lift::count_if_prefetched(items.begin(), items.end(), owned_by_2,
+                                          select_owner, d) == expected);
+      }
+    }
+  }
+  AND_WHEN("finding")
+  {
+    THEN("the result is that of find_if")
+    {
+      auto owned_by_3 = lift::compose(lift::equal(3), select_owner_id);
+      REQUIRE(lift::find_if_prefetched(items.begin(), items.end(), owned_by_3, select_owner)
+              == items.begin() + 2);
+      REQUIRE(lift::find_if_prefetched(items.begin(), items.end(), lift::compose(lift::equal(4), select_owner_id), select_owner)
+              == items.end());
+    }
+  }
+  AND_WHEN("the range is only forward iterable")
+  {
+    std::list<item> l(items.begin(), items.end());
+    THEN("it works the same")
+    {
+      REQUIRE(lift::count_if_prefetched(l.begin(), l.end(), owned_by_2, select_owner, 8) == 20);
+    }
+  }
+}